@@ -0,0 +1,408 @@
+/**
+ * Implements snapshots of a running search, so that a killed search can be resumed
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include "treeNode.h"
+#include "frontierNode.h"
+#include "checkpoint.h"
+
+pid_t snapshotWriter = -1; //child process writing a snapshot, -1 if there is none
+
+/**Finds the row and column of 0 in a puzzle
+ *
+ * @param puzzle
+ * @param size size of the puzzle
+ * @param iZ stores the row of 0
+ * @param jZ stores the column of 0
+ */
+void findBlank(int **puzzle, int size, int *iZ, int *jZ);
+
+/**Writes a tree in preorder, one hex digit per node with a bit for each child, and stores the preorder
+ * index of every node in the node
+ *
+ * @param f snapshot file
+ * @param node
+ * @param index stores the next preorder index
+ */
+void writeTree(FILE *f, tree_node *node, int *index);
+
+/**Writes a non-negative number and a new line, faster than fprintf for the millions of queued nodes
+ *
+ * @param f snapshot file
+ * @param number
+ */
+void writeIndex(FILE *f, int number);
+
+/**Rebuilds the children of a node from a tree written in preorder
+ *
+ * @param f snapshot file
+ * @param node
+ * @param size size of the puzzle
+ * @param solution solution of the puzzle
+ * @param nodes stores every node at its preorder index
+ * @param index stores the next preorder index
+ * @param nodeCount number of nodes in the snapshot
+ * @return true or false if the tree is not valid
+ */
+bool readTree(FILE *f, tree_node *node, int size, int **solution, tree_node **nodes, int *index, int nodeCount);
+
+/**Finds the child of a node for a move of 0. If the child is not in the tree yet, it is created.
+ *
+ * @param node
+ * @param move 'r', 'd', 'l' or 'u'
+ * @param size size of the puzzle
+ * @param solution solution of the puzzle
+ * @return the child or NULL if the move is not possible
+ */
+tree_node *childOfMove(tree_node *node, char move, int size, int **solution);
+
+/**Opens the temporary file of a snapshot for writing
+ *
+ * @param fileName name of the snapshot file
+ * @param tempName stores the name of the temporary file
+ * @return the file or NULL
+ */
+FILE *openSnapshot(const char *fileName, char **tempName);
+
+/**Closes the temporary file of a snapshot and renames it over the snapshot file
+ *
+ * @param f temporary file
+ * @param tempName name of the temporary file, freed here
+ * @param fileName name of the snapshot file
+ * @return 0 on success, 1 otherwise
+ */
+int closeSnapshot(FILE *f, char *tempName, const char *fileName);
+
+/**Checks if the writer of the last snapshot has finished
+ *
+ * @param wait true to wait for the writer, false to only check on it
+ * @return 0 if there is no writer left, 1 if it is still running, 2 if it could not write the snapshot
+ */
+int reapSnapshot(bool wait);
+
+/**Writes the algorithm, the size and the original puzzle of a search
+ *
+ * @param f snapshot file
+ * @param strategy name of the algorithm
+ * @param size size of the puzzle
+ * @param puzzle original puzzle
+ */
+void writeHeader(FILE *f, const char *strategy, int size, int **puzzle);
+
+/**Checks if a snapshot was written by the same algorithm for the same puzzle
+ *
+ * @param f snapshot file
+ * @param strategy name of the algorithm
+ * @param size size of the puzzle
+ * @param puzzle original puzzle
+ * @return true or false
+ */
+bool readHeader(FILE *f, const char *strategy, int size, int **puzzle);
+
+void findBlank(int **puzzle, int size, int *iZ, int *jZ) {
+    int i, j;
+    for (i = 0; i < size; i++) {
+        for (j = 0; j < size; j++) {
+            if (puzzle[i][j] == 0) {
+                *iZ = i;
+                *jZ = j;
+            }
+        }
+    }
+}
+
+void writeIndex(FILE *f, int number) {
+    char digits[12];
+    int count = 0;
+    do {
+        digits[count++] = (char) ('0' + number % 10);
+        number /= 10;
+    } while (number > 0);
+    while (count > 0) {
+        putc(digits[--count], f);
+    }
+    putc('\n', f);
+}
+
+void writeTree(FILE *f, tree_node *node, int *index) {
+    int mask = (node->right != NULL) | (node->down != NULL) << 1 | (node->left != NULL) << 2 |
+               (node->up != NULL) << 3;
+    node->snapshotIndex = (*index)++;
+    fputc("0123456789abcdef"[mask], f);
+    if (node->right != NULL) writeTree(f, node->right, index);
+    if (node->down != NULL) writeTree(f, node->down, index);
+    if (node->left != NULL) writeTree(f, node->left, index);
+    if (node->up != NULL) writeTree(f, node->up, index);
+}
+
+FILE *openSnapshot(const char *fileName, char **tempName) {
+    *tempName = (char *) malloc(strlen(fileName) + 5);
+    if (*tempName == NULL) return NULL;
+    strcpy(*tempName, fileName);
+    strcat(*tempName, ".tmp");
+
+    FILE *f = fopen(*tempName, "w");
+    if (f == NULL) {
+        free(*tempName);
+        *tempName = NULL;
+    }
+    return f;
+}
+
+int closeSnapshot(FILE *f, char *tempName, const char *fileName) {
+    if (fclose(f) != 0 || rename(tempName, fileName) != 0) {
+        remove(tempName);
+        free(tempName);
+        return 1;
+    }
+    free(tempName);
+    return 0;
+}
+
+void writeHeader(FILE *f, const char *strategy, int size, int **puzzle) {
+    int i, j;
+    fprintf(f, "%s %d\n", strategy, size);
+    for (i = 0; i < size; i++) {
+        for (j = 0; j < size; j++) {
+            fprintf(f, "%d ", puzzle[i][j]);
+        }
+        fprintf(f, "\n");
+    }
+}
+
+bool readHeader(FILE *f, const char *strategy, int size, int **puzzle) {
+    char storedStrategy[50];
+    int storedSize, value, i, j;
+    if (fscanf(f, "%49s %d", storedStrategy, &storedSize) != 2 || strcmp(storedStrategy, strategy) != 0 ||
+        storedSize != size) {
+        return false;
+    }
+    for (i = 0; i < size; i++) {
+        for (j = 0; j < size; j++) {
+            if (fscanf(f, "%d", &value) != 1 || value != puzzle[i][j]) return false;
+        }
+    }
+    return true;
+}
+
+int writeSnapshot(const char *fileName, const char *strategy, int size, int **puzzle, tree_node *root,
+                  frontier_node *head) {
+    int count = 0, index = 0;
+    char *tempName;
+    frontier_node *current;
+    FILE *f = openSnapshot(fileName, &tempName);
+    if (f == NULL) return 1;
+
+    for (current = head; current != NULL; current = current->next) {
+        count++;
+    }
+    writeHeader(f, strategy, size, puzzle);
+    fprintf(f, "%d\n", count);
+    writeTree(f, root, &index);
+    fputc('\n', f);
+    for (current = head; current != NULL; current = current->next) {
+        writeIndex(f, current->leaf->snapshotIndex);
+    }
+    return closeSnapshot(f, tempName, fileName);
+}
+
+int reapSnapshot(bool wait) {
+    int status;
+    pid_t done;
+    if (snapshotWriter < 0) return 0;
+    done = waitpid(snapshotWriter, &status, wait ? 0 : WNOHANG);
+    if (done == 0) return 1;
+    snapshotWriter = -1;
+    return done < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0 ? 2 : 0;
+}
+
+int startSnapshot(const char *fileName, const char *strategy, int size, int **puzzle, tree_node *root,
+                  frontier_node *head) {
+    int finished = reapSnapshot(false);
+    pid_t writer;
+    if (finished == 1) return 0;
+    writer = fork();
+    if (writer == 0) {
+        //_exit does not flush the stdout buffer the child shares with the search
+        _exit(writeSnapshot(fileName, strategy, size, puzzle, root, head));
+    }
+    if (writer < 0) {
+        return writeSnapshot(fileName, strategy, size, puzzle, root, head) != 0 || finished != 0;
+    }
+    snapshotWriter = writer;
+    return finished != 0;
+}
+
+void stopSnapshot(const char *fileName) {
+    char *tempName;
+    if (snapshotWriter < 0) return;
+    kill(snapshotWriter, SIGKILL);
+    reapSnapshot(true);
+    tempName = (char *) malloc(strlen(fileName) + 5);
+    if (tempName == NULL) return;
+    strcpy(tempName, fileName);
+    strcat(tempName, ".tmp");
+    remove(tempName);
+    free(tempName);
+}
+
+tree_node *childOfMove(tree_node *node, char move, int size, int **solution) {
+    int i, iZero = 0, jZero = 0, iMove, jMove;
+    tree_node **child;
+    findBlank(node->puzzle, size, &iZero, &jZero);
+    iMove = iZero;
+    jMove = jZero;
+    if (move == 'r') {
+        jMove++;
+        child = &node->right;
+    } else if (move == 'd') {
+        iMove++;
+        child = &node->down;
+    } else if (move == 'l') {
+        jMove--;
+        child = &node->left;
+    } else if (move == 'u') {
+        iMove--;
+        child = &node->up;
+    } else {
+        return NULL;
+    }
+    if (iMove < 0 || iMove >= size || jMove < 0 || jMove >= size) return NULL;
+    if (*child != NULL) return *child;
+
+    int **temparray = (int **) malloc(sizeof(int *) * size);
+    if (temparray == NULL) return NULL;
+    for (i = 0; i < size; i++) {
+        temparray[i] = (int *) malloc(sizeof(int) * size);
+        memcpy(temparray[i], node->puzzle[i], sizeof(int) * size);
+    }
+    temparray[iZero][jZero] = temparray[iMove][jMove];
+    temparray[iMove][jMove] = 0;
+    *child = insertTreeNode(temparray, node, solution);
+    for (i = 0; i < size; i++)
+        free(temparray[i]);
+    free(temparray);
+    return *child;
+}
+
+bool readTree(FILE *f, tree_node *node, int size, int **solution, tree_node **nodes, int *index, int nodeCount) {
+    const char moves[] = "rdlu";
+    int c = fgetc(f), mask, k;
+    if (*index >= nodeCount) return false;
+    if (c >= '0' && c <= '9') {
+        mask = c - '0';
+    } else if (c >= 'a' && c <= 'f') {
+        mask = c - 'a' + 10;
+    } else {
+        return false;
+    }
+    nodes[(*index)++] = node;
+    for (k = 0; k < 4; k++) {
+        if (!(mask & 1 << k)) continue;
+        tree_node *child = childOfMove(node, moves[k], size, solution);
+        if (child == NULL || !readTree(f, child, size, solution, nodes, index, nodeCount)) return false;
+    }
+    return true;
+}
+
+int readSnapshot(const char *fileName, const char *strategy, int size, tree_node *root, int **solution,
+                 frontier_node **head, frontier_node **tail) {
+    int nodeCount = 0, count, index = 0, i, c;
+    long start = -1;
+    bool valid;
+    tree_node **nodes = NULL;
+
+    FILE *f = fopen(fileName, "r");
+    if (f == NULL) return 1;
+    valid = readHeader(f, strategy, size, root->puzzle) && fscanf(f, "%d", &count) == 1 && count > 0 &&
+            fgetc(f) == '\n';
+    //the tree line has a digit for every node
+    if (valid) start = ftell(f);
+    while (start >= 0 && (c = fgetc(f)) != '\n' && c != EOF) {
+        nodeCount++;
+    }
+    valid = valid && nodeCount > 0 && fseek(f, start, SEEK_SET) == 0;
+    if (valid) {
+        nodes = (tree_node **) malloc(sizeof(tree_node *) * nodeCount);
+        valid = nodes != NULL && readTree(f, root, size, solution, nodes, &index, nodeCount) &&
+                index == nodeCount;
+    }
+    for (i = 0; i < count && valid; i++) {
+        valid = fscanf(f, "%d", &index) == 1 && index >= 0 && index < nodeCount &&
+                enqueue(head, tail, nodes[index]) == 0;
+    }
+    free(nodes);
+    fclose(f);
+
+    if (!valid) {
+        while (!isEmpty(*head)) {
+            dequeue(head, tail);
+        }
+        deleteTree(root->right);
+        deleteTree(root->down);
+        deleteTree(root->left);
+        deleteTree(root->up);
+        root->right = root->down = root->left = root->up = NULL;
+        return 1;
+    }
+    return 0;
+}
+
+int writeIdaSnapshot(const char *fileName, int size, int **puzzle, int threshold, int nextThreshold, int taskCount,
+                     const unsigned char *done) {
+    int i;
+    char *tempName;
+    FILE *f = openSnapshot(fileName, &tempName);
+    if (f == NULL) return 1;
+
+    writeHeader(f, "ida-star", size, puzzle);
+    fprintf(f, "%d %d %d\n", threshold, nextThreshold, taskCount);
+    for (i = 0; i < taskCount; i++) {
+        fputc(done[i] ? '1' : '0', f);
+    }
+    fputc('\n', f);
+    return closeSnapshot(f, tempName, fileName);
+}
+
+int readIdaSnapshot(const char *fileName, int size, int **puzzle, int taskCount, int minThreshold, int maxThreshold,
+                    int *threshold, int *nextThreshold, unsigned char *done) {
+    int storedThreshold, storedNext, storedCount, i, c;
+    bool valid;
+
+    FILE *f = fopen(fileName, "r");
+    if (f == NULL) return 1;
+    valid = readHeader(f, "ida-star", size, puzzle) &&
+            fscanf(f, "%d %d %d", &storedThreshold, &storedNext, &storedCount) == 3 &&
+            storedCount == taskCount && storedThreshold >= minThreshold && storedThreshold < maxThreshold &&
+            storedNext > storedThreshold && fgetc(f) == '\n';
+    unsigned char *flags = valid ? (unsigned char *) malloc(taskCount) : NULL;
+    valid = flags != NULL;
+    for (i = 0; i < taskCount && valid; i++) {
+        c = fgetc(f);
+        valid = c == '0' || c == '1';
+        flags[i] = (unsigned char) (c == '1');
+    }
+    //the flags have to end here, a longer string is a snapshot of another split
+    if (valid) {
+        c = fgetc(f);
+        valid = c == '\n' || c == EOF;
+    }
+    fclose(f);
+
+    if (valid) {
+        *threshold = storedThreshold;
+        *nextThreshold = storedNext;
+        memcpy(done, flags, taskCount);
+    }
+    free(flags);
+    return valid ? 0 : 1;
+}
@@ -0,0 +1,103 @@
+#ifndef HW3_CHECKPOINT_H
+#define HW3_CHECKPOINT_H
+
+#include "treeNode.h"
+#include "frontierNode.h"
+
+//Seconds between 2 snapshots of a running search
+#ifndef CHECKPOINT_SECONDS
+#define CHECKPOINT_SECONDS 60
+#endif
+
+/**Writes the tree and the queue of a search on a snapshot file. The tree is stored once in preorder,
+ * one hex digit per node with a bit for each child (right 1, down 2, left 4, up 8), after it the queue as
+ * the preorder indexes of its nodes. Nothing is searched for, so writing is linear in the size of the tree.
+ * The file is streamed to fileName.tmp and renamed when complete, so an older snapshot stays valid if
+ * the program is killed while writing.
+ *
+ * @param fileName name of the snapshot file
+ * @param strategy name of the algorithm
+ * @param size size of the puzzle
+ * @param puzzle original puzzle
+ * @param root root of the tree
+ * @param head head of queue
+ * @return 0 on success, 1 if the file could not be written
+ */
+int writeSnapshot(const char *fileName, const char *strategy, int size, int **puzzle, tree_node *root,
+                  frontier_node *head);
+
+/**Writes a snapshot in a child process, so the search only pauses for the fork. The child gets a
+ * copy-on-write view of the tree and the queue as they are now, and the search goes on while it writes.
+ * The fork copies the page tables of the process, so the pause grows with the memory of the search
+ * (about 20 milliseconds per gigabyte), not with the time to write the file. The child stores the preorder
+ * indexes in its own copy of the nodes, so while it writes, the pages of the tree are held twice.
+ * If the last writer is still running, no snapshot is started. If the fork fails, the snapshot is
+ * written by the search itself.
+ *
+ * @param fileName name of the snapshot file
+ * @param strategy name of the algorithm
+ * @param size size of the puzzle
+ * @param puzzle original puzzle
+ * @param root root of the tree
+ * @param head head of queue
+ * @return 0 on success, 1 if this snapshot or the last one could not be written
+ */
+int startSnapshot(const char *fileName, const char *strategy, int size, int **puzzle, tree_node *root,
+                  frontier_node *head);
+
+/**Stops the writer of a snapshot, if there is one running, and removes the file it was writing.
+ * The last complete snapshot is not touched.
+ *
+ * @param fileName name of the snapshot file
+ */
+void stopSnapshot(const char *fileName);
+
+/**Reads a snapshot file and rebuilds the tree and the queue of the search that wrote it.
+ * The nodes are enqueued in the order they were stored, so the queue keeps its sorting.
+ * Only the root of the tree is given, the rest of the tree is read from the snapshot.
+ *
+ * @param fileName name of the snapshot file
+ * @param strategy name of the algorithm
+ * @param size size of the puzzle
+ * @param root root of the tree, holds the original puzzle
+ * @param solution solution of the puzzle
+ * @param head head of queue
+ * @param tail tail of queue
+ * @return 0 on success, 1 if there is no snapshot of this search
+ */
+int readSnapshot(const char *fileName, const char *strategy, int size, tree_node *root, int **solution,
+                 frontier_node **head, frontier_node **tail);
+
+/**Writes the state of a parallel IDA* search on a snapshot file: the threshold of the current iteration,
+ * the smallest cost above it found so far and which subtree tasks of the iteration are finished.
+ *
+ * @param fileName name of the snapshot file
+ * @param size size of the puzzle
+ * @param puzzle original puzzle
+ * @param threshold threshold of the current iteration
+ * @param nextThreshold smallest cost above the threshold in the finished tasks
+ * @param taskCount number of subtree tasks
+ * @param done 1 for every finished task
+ * @return 0 on success, 1 if the file could not be written
+ */
+int writeIdaSnapshot(const char *fileName, int size, int **puzzle, int threshold, int nextThreshold, int taskCount,
+                     const unsigned char *done);
+
+/**Reads the state of a parallel IDA* search from a snapshot file. Nothing is stored unless the whole
+ * snapshot is valid: same number of tasks, a flag for every task and thresholds in range.
+ *
+ * @param fileName name of the snapshot file
+ * @param size size of the puzzle
+ * @param puzzle original puzzle
+ * @param taskCount number of subtree tasks
+ * @param minThreshold threshold of the first iteration
+ * @param maxThreshold the threshold has to be below this
+ * @param threshold stores the threshold of the iteration
+ * @param nextThreshold stores the smallest cost above the threshold in the finished tasks
+ * @param done stores 1 for every finished task
+ * @return 0 on success, 1 if there is no valid snapshot of this search
+ */
+int readIdaSnapshot(const char *fileName, int size, int **puzzle, int taskCount, int minThreshold, int maxThreshold,
+                    int *threshold, int *nextThreshold, unsigned char *done);
+
+#endif //HW3_CHECKPOINT_H
@@ -37,6 +37,26 @@ int enqueueStar(frontier_node **head, frontier_node **tail, tree_node *leaf);
  */
 int enqueueBest(frontier_node **head, frontier_node **tail, tree_node *leaf);
 
+/**Inserts an element in a sorted queue based on weighted A* algorithm (based on distance from root+
+ * STAR_WEIGHT*distance from goal)
+ *
+ * @param head head of queue
+ * @param tail tail of queue
+ * @param leaf tree node
+ * @return
+ */
+int enqueueWeighted(frontier_node **head, frontier_node **tail, tree_node *leaf);
+
+/**Inserts an element in a sorted queue based on optimal A* algorithm (based on moves from root+distance
+ * from goal). The distance from goal never counts too many moves, so the first solution is a shortest one.
+ *
+ * @param head head of queue
+ * @param tail tail of queue
+ * @param leaf tree node
+ * @return
+ */
+int enqueueOptimal(frontier_node **head, frontier_node **tail, tree_node *leaf);
+
 /**Inserts an element at the end-tail of queue
  *
  * @param head head of queue
@@ -46,6 +66,17 @@ int enqueueBest(frontier_node **head, frontier_node **tail, tree_node *leaf);
  */
 int enqueue(frontier_node **head, frontier_node **tail, tree_node *leaf);
 
+/**Inserts an element with the enqueue method of the given algorithm: "best", "a-star", "weighted-star",
+ * "optimal-star" or breadth-first for any other name
+ *
+ * @param head head of queue
+ * @param tail tail of queue
+ * @param leaf tree node
+ * @param strategy name of the algorithm
+ * @return
+ */
+int enqueueStrategy(frontier_node **head, frontier_node **tail, tree_node *leaf, const char *strategy);
+
 /**Removes the first element -Head of the queue. Frees the memory and selects a new head if possible
  *
  * @param head head of queue
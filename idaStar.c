@@ -0,0 +1,576 @@
+/**
+ * Implements the parallel IDA* search with subtree tasks on work-stealing deques
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <limits.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include "idaStar.h"
+#include "checkpoint.h"
+#include "symmetry.h"
+
+//Subtree of the search below the breadth-first split of the root
+typedef struct ida_task
+{
+    unsigned char tiles[IDA_MAX_CELLS];
+    unsigned char canonical[IDA_MAX_CELLS]; //same for reflected tasks
+    char path[IDA_MAX_SPLIT];
+    int blank;
+    int g;
+    int h; //Manhattan distance from goal
+    int lastMove;
+} ida_task;
+
+//Deque of task indexes, the owner takes from the bottom and the other workers steal from the top
+typedef struct ida_deque
+{
+    int *tasks;
+    int top;
+    int bottom;
+    pthread_mutex_t lock;
+} ida_deque;
+
+//State shared by all the workers of a search
+typedef struct ida_search
+{
+    int size;
+    int cells;
+    int *distance; //distance[tile * cells + position] is the Manhattan distance of the tile from its goal
+    ida_task *tasks;
+    int taskCount;
+    ida_deque deques[IDA_MAX_THREADS];
+    int threadCount;
+    int threshold; //atomic, threshold of the current iteration
+    int bestCost; //atomic, INT_MAX until a solution is found
+    int stopped; //atomic, 1 once another strategy of the portfolio has solved the puzzle
+    bool (*isCancelled)(void); //NULL outside of the portfolio
+    char solution[IDA_MAX_PATH];
+    pthread_mutex_t progressLock; //guards the fields below
+    int nextThreshold;
+    unsigned char *done;
+    const char *snapshotFile;
+    int **puzzle;
+    time_t lastSnapshot;
+} ida_search;
+
+//Worker thread with its own copy of the board
+typedef struct ida_worker
+{
+    ida_search *search;
+    int id;
+    int threshold;
+    int nextThreshold;
+    unsigned long nodes; //nodes searched, to ask for cancellation every IDA_CANCEL_NODES
+    unsigned char tiles[IDA_MAX_CELLS];
+    char path[IDA_MAX_PATH];
+    int rows[IDA_MAX_SIDE]; //row conflicts of every row
+    int columns[IDA_MAX_SIDE]; //conflicts of every column, the row conflicts of the reflected board
+} ida_worker;
+
+//Moves of 0, in the order they are tried
+const char idaMoves[] = "rdlu";
+const char *idaMoveNames[] = {"right", "down", "left", "up"};
+
+/**Finds the square where 0 goes with a move
+ *
+ * @param size size of the puzzle
+ * @param blank square of 0
+ * @param move index of the move in idaMoves
+ * @return the square or -1 if the move is not possible
+ */
+int idaTarget(int size, int blank, int move);
+
+/**Checks if the tiles are a permutation that can reach the solution
+ *
+ * @param tiles
+ * @param size size of the puzzle
+ * @return true or false
+ */
+bool idaSolvable(const unsigned char *tiles, int size);
+
+/**Orders tasks by their canonical board
+ *
+ * @param first task
+ * @param second task
+ * @return negative, 0 or positive like memcmp
+ */
+int idaCompareTasks(const void *first, const void *second);
+
+/**Splits the root breadth-first into at least IDA_SPLIT_TASKS subtree tasks. Tasks of the same level
+ * with the same canonical board have the same subtree up to reflection, so only one of them is kept.
+ * If the solution is reached during the split, it is kept as the only task.
+ *
+ * @param search
+ * @param root task of the whole tree
+ * @return 0 on success, 1 otherwise
+ */
+int idaSplit(ida_search *search, const ida_task *root);
+
+/**Takes a task from the deque of a worker, or steals one from the deque of another worker
+ *
+ * @param search
+ * @param id worker
+ * @return index of the task or -1 if all deques are empty
+ */
+int idaTakeTask(ida_search *search, int id);
+
+/**Checks if the search has to stop, because the solution is found or because another strategy of the
+ * portfolio has solved the puzzle
+ *
+ * @param search
+ * @return true or false
+ */
+bool idaStopped(ida_search *search);
+
+/**Depth-first search of a worker up to the threshold of the iteration
+ *
+ * @param worker
+ * @param blank square of 0
+ * @param g distance from root
+ * @param h Manhattan distance from goal
+ * @param lastMove index of the move that created the board or -1
+ * @return true if the search has to stop
+ */
+bool idaDepthFirst(ida_worker *worker, int blank, int g, int h, int lastMove);
+
+/**Calculates the conflicts of the board of a worker, its row plus column conflicts
+ *
+ * @param worker
+ * @return linear conflicts
+ */
+int idaConflicts(ida_worker *worker);
+
+/**Calculates again the conflicts of the lines crossed by a move of 0 between 2 squares
+ *
+ * @param worker
+ * @param first square
+ * @param second square
+ * @param saved stores the conflicts before the move
+ */
+void idaUpdateLines(ida_worker *worker, int first, int second, int *saved);
+
+/**Restores the conflicts of the lines crossed by a move of 0 when the move is taken back
+ *
+ * @param worker
+ * @param first square
+ * @param second square
+ * @param saved conflicts before the move
+ */
+void idaRestoreLines(ida_worker *worker, int first, int second, const int *saved);
+
+/**Thread routine of a worker, searches tasks until the deques are empty or the solution is found
+ *
+ * @param arg worker
+ * @return NULL
+ */
+void *idaWorker(void *arg);
+
+int idaTarget(int size, int blank, int move) {
+    int row = blank / size, column = blank % size;
+    if (move == 0) return column + 1 < size ? blank + 1 : -1;
+    if (move == 1) return row + 1 < size ? blank + size : -1;
+    if (move == 2) return column > 0 ? blank - 1 : -1;
+    return row > 0 ? blank - size : -1;
+}
+
+bool idaSolvable(const unsigned char *tiles, int size) {
+    int cells = size * size, swaps = 0, length, i, position;
+    bool seen[IDA_MAX_CELLS];
+    memset(seen, 0, sizeof(seen));
+    for (i = 0; i < cells; i++) {
+        if (tiles[i] >= cells || seen[tiles[i]]) return false;
+        seen[tiles[i]] = true;
+    }
+    //parity of the permutation of squares has to match the parity of the moves of 0 to its goal
+    memset(seen, 0, sizeof(seen));
+    for (i = 0; i < cells; i++) {
+        for (position = i, length = 0; !seen[position]; length++) {
+            seen[position] = true;
+            position = tiles[position] == 0 ? cells - 1 : tiles[position] - 1;
+        }
+        if (length > 0) swaps += length - 1;
+    }
+    for (i = 0; tiles[i] != 0; i++);
+    return swaps % 2 == (size - 1 - i / size + size - 1 - i % size) % 2;
+}
+
+int idaCompareTasks(const void *first, const void *second) {
+    return memcmp(((const ida_task *) first)->canonical, ((const ida_task *) second)->canonical, IDA_MAX_CELLS);
+}
+
+int idaSplit(ida_search *search, const ida_task *root) {
+    int count = 1, nextCount, i, move, target;
+    ida_task *level = (ida_task *) malloc(sizeof(ida_task));
+    if (level == NULL) return 1;
+    level[0] = *root;
+
+    while (true) {
+        for (i = 0; i < count; i++) {
+            if (level[i].h == 0) {
+                level[0] = level[i];
+                count = 1;
+                break;
+            }
+        }
+        if (count >= IDA_SPLIT_TASKS || level[0].h == 0 || level[0].g >= IDA_MAX_SPLIT - 1) break;
+
+        ida_task *next = (ida_task *) malloc(sizeof(ida_task) * count * 4);
+        if (next == NULL) {
+            free(level);
+            return 1;
+        }
+        nextCount = 0;
+        for (i = 0; i < count; i++) {
+            for (move = 0; move < 4; move++) {
+                if (level[i].lastMove >= 0 && move == (level[i].lastMove + 2) % 4) continue;
+                target = idaTarget(search->size, level[i].blank, move);
+                if (target < 0) continue;
+                ida_task *child = &next[nextCount++];
+                unsigned char tile = level[i].tiles[target];
+                *child = level[i];
+                child->tiles[level[i].blank] = tile;
+                child->tiles[target] = 0;
+                child->path[child->g] = idaMoves[move];
+                child->g++;
+                child->h += search->distance[tile * search->cells + level[i].blank] -
+                            search->distance[tile * search->cells + target];
+                child->blank = target;
+                child->lastMove = move;
+                canonicalBoard(child->tiles, child->canonical, search->size);
+            }
+        }
+        free(level);
+        qsort(next, nextCount, sizeof(ida_task), idaCompareTasks);
+        count = 0;
+        for (i = 0; i < nextCount; i++) {
+            if (count == 0 || idaCompareTasks(&next[count - 1], &next[i]) != 0) next[count++] = next[i];
+        }
+        level = next;
+    }
+    search->tasks = level;
+    search->taskCount = count;
+    return 0;
+}
+
+int idaTakeTask(ida_search *search, int id) {
+    int index = -1, k;
+    ida_deque *deque = &search->deques[id];
+    pthread_mutex_lock(&deque->lock);
+    if (deque->bottom > deque->top) index = deque->tasks[--deque->bottom];
+    pthread_mutex_unlock(&deque->lock);
+
+    for (k = 1; k < search->threadCount && index < 0; k++) {
+        deque = &search->deques[(id + k) % search->threadCount];
+        pthread_mutex_lock(&deque->lock);
+        if (deque->bottom > deque->top) index = deque->tasks[deque->top++];
+        pthread_mutex_unlock(&deque->lock);
+    }
+    return index;
+}
+
+bool idaStopped(ida_search *search) {
+    return __atomic_load_n(&search->bestCost, __ATOMIC_RELAXED) != INT_MAX ||
+           __atomic_load_n(&search->stopped, __ATOMIC_RELAXED);
+}
+
+int idaConflicts(ida_worker *worker) {
+    int conflicts = 0, line;
+    for (line = 0; line < worker->search->size; line++) {
+        conflicts += worker->rows[line] + worker->columns[line];
+    }
+    return conflicts;
+}
+
+void idaUpdateLines(ida_worker *worker, int first, int second, int *saved) {
+    int size = worker->search->size;
+    //a tile keeps its order in the line it moves along, only the 2 crossing lines change
+    if (first / size == second / size) {
+        saved[0] = worker->columns[first % size];
+        saved[1] = worker->columns[second % size];
+        worker->columns[first % size] = lineConflicts(worker->tiles, size, first % size, true);
+        worker->columns[second % size] = lineConflicts(worker->tiles, size, second % size, true);
+    } else {
+        saved[0] = worker->rows[first / size];
+        saved[1] = worker->rows[second / size];
+        worker->rows[first / size] = lineConflicts(worker->tiles, size, first / size, false);
+        worker->rows[second / size] = lineConflicts(worker->tiles, size, second / size, false);
+    }
+}
+
+void idaRestoreLines(ida_worker *worker, int first, int second, const int *saved) {
+    int size = worker->search->size;
+    if (first / size == second / size) {
+        worker->columns[first % size] = saved[0];
+        worker->columns[second % size] = saved[1];
+    } else {
+        worker->rows[first / size] = saved[0];
+        worker->rows[second / size] = saved[1];
+    }
+}
+
+bool idaDepthFirst(ida_worker *worker, int blank, int g, int h, int lastMove) {
+    ida_search *search = worker->search;
+    int f = g + h + idaConflicts(worker), move, target, expected = INT_MAX;
+    int saved[2], tileH;
+    unsigned char tile;
+
+    if (f > worker->threshold) {
+        if (f < worker->nextThreshold) worker->nextThreshold = f;
+        return false;
+    }
+    if (h == 0) {
+        //every cost up to the threshold of the previous iteration failed, so this solution is optimal
+        if (__atomic_compare_exchange_n(&search->bestCost, &expected, g, false, __ATOMIC_ACQ_REL,
+                                        __ATOMIC_ACQUIRE)) {
+            memcpy(search->solution, worker->path, g);
+        }
+        return true;
+    }
+    if (idaStopped(search)) return true;
+    if (search->isCancelled != NULL && (++worker->nodes & (IDA_CANCEL_NODES - 1)) == 0 && search->isCancelled()) {
+        __atomic_store_n(&search->stopped, 1, __ATOMIC_RELAXED);
+        return true;
+    }
+
+    for (move = 0; move < 4; move++) {
+        if (lastMove >= 0 && move == (lastMove + 2) % 4) continue;
+        target = idaTarget(search->size, blank, move);
+        if (target < 0) continue;
+        tile = worker->tiles[target];
+        tileH = h + search->distance[tile * search->cells + blank] - search->distance[tile * search->cells + target];
+        //conflicts only add to the Manhattan distance, so they are not needed to cut this child
+        if (g + 1 + tileH > worker->threshold) {
+            if (g + 1 + tileH < worker->nextThreshold) worker->nextThreshold = g + 1 + tileH;
+            continue;
+        }
+        worker->tiles[blank] = tile;
+        worker->tiles[target] = 0;
+        worker->path[g] = idaMoves[move];
+        idaUpdateLines(worker, blank, target, saved);
+        if (idaDepthFirst(worker, target, g + 1, tileH, move)) {
+            return true;
+        }
+        idaRestoreLines(worker, blank, target, saved);
+        worker->tiles[target] = tile;
+        worker->tiles[blank] = 0;
+    }
+    return false;
+}
+
+void *idaWorker(void *arg) {
+    ida_worker *worker = (ida_worker *) arg;
+    ida_search *search = worker->search;
+    int index, line;
+    worker->threshold = __atomic_load_n(&search->threshold, __ATOMIC_ACQUIRE);
+
+    while (!idaStopped(search) && (index = idaTakeTask(search, worker->id)) >= 0) {
+        ida_task *task = &search->tasks[index];
+        memcpy(worker->tiles, task->tiles, search->cells);
+        memcpy(worker->path, task->path, task->g);
+        for (line = 0; line < search->size; line++) {
+            worker->rows[line] = lineConflicts(worker->tiles, search->size, line, false);
+            worker->columns[line] = lineConflicts(worker->tiles, search->size, line, true);
+        }
+        worker->nextThreshold = INT_MAX;
+        if (idaDepthFirst(worker, task->blank, task->g, task->h, task->lastMove)) break;
+
+        pthread_mutex_lock(&search->progressLock);
+        if (worker->nextThreshold < search->nextThreshold) search->nextThreshold = worker->nextThreshold;
+        search->done[index] = 1;
+        if (search->snapshotFile != NULL && difftime(time(NULL), search->lastSnapshot) >= CHECKPOINT_SECONDS) {
+            if (writeIdaSnapshot(search->snapshotFile, search->size, search->puzzle, worker->threshold,
+                                 search->nextThreshold, search->taskCount, search->done) != 0) {
+                printf("\nCould not write snapshot %s\n", search->snapshotFile);
+            }
+            search->lastSnapshot = time(NULL);
+        }
+        pthread_mutex_unlock(&search->progressLock);
+    }
+    return NULL;
+}
+
+bool puzzleSolvable(int **puzzle, int size) {
+    unsigned char tiles[IDA_MAX_CELLS];
+    int i, j;
+    if (size * size > IDA_MAX_CELLS) return true;
+    for (i = 0; i < size; i++) {
+        for (j = 0; j < size; j++) {
+            if (puzzle[i][j] < 0 || puzzle[i][j] >= size * size) return false;
+            tiles[i * size + j] = (unsigned char) puzzle[i][j];
+        }
+    }
+    return idaSolvable(tiles, size);
+}
+
+int solveIdaStar(int **puzzle, int size, const char *fileName, const char *snapshotFile,
+                 bool (*claim)(const char *strategy), bool (*cancelled)(void)) {
+    int i, j, tile, position, started;
+    int cells = size * size;
+    ida_search search;
+    ida_task root;
+    ida_worker *workers;
+    pthread_t threads[IDA_MAX_THREADS];
+
+    if (cells > IDA_MAX_CELLS) {
+        printf("\nPuzzle is too large for ida-star.\n");
+        return 1;
+    }
+    memset(&root, 0, sizeof(root));
+    root.blank = 0;
+    root.g = 0;
+    root.h = 0;
+    root.lastMove = -1;
+    for (i = 0; i < size; i++) {
+        for (j = 0; j < size; j++) {
+            if (puzzle[i][j] < 0 || puzzle[i][j] >= cells) {
+                if (claim == NULL) printf("\n\nPuzzle has no solution.");
+                return 0;
+            }
+            root.tiles[i * size + j] = (unsigned char) puzzle[i][j];
+            if (puzzle[i][j] == 0) root.blank = i * size + j;
+        }
+    }
+    if (!idaSolvable(root.tiles, size)) {
+        if (claim == NULL) printf("\n\nPuzzle has no solution.");
+        return 0;
+    }
+
+    search.size = size;
+    search.cells = cells;
+    search.distance = (int *) malloc(sizeof(int) * cells * cells);
+    if (search.distance == NULL) return 1;
+    for (tile = 0; tile < cells; tile++) {
+        for (position = 0; position < cells; position++) {
+            int goal = tile - 1;
+            search.distance[tile * cells + position] =
+                    tile == 0 ? 0 : abs(position / size - goal / size) + abs(position % size - goal % size);
+        }
+    }
+    for (position = 0; position < cells; position++) {
+        root.h += search.distance[root.tiles[position] * cells + position];
+    }
+    if (idaSplit(&search, &root) != 0) {
+        free(search.distance);
+        return 1;
+    }
+
+    search.threadCount = (int) sysconf(_SC_NPROCESSORS_ONLN);
+    if (search.threadCount < 1) search.threadCount = 1;
+    if (search.threadCount > IDA_MAX_THREADS) search.threadCount = IDA_MAX_THREADS;
+    search.done = (unsigned char *) calloc(search.taskCount, 1);
+    workers = (ida_worker *) malloc(sizeof(ida_worker) * search.threadCount);
+    if (search.done == NULL || workers == NULL) {
+        free(search.done);
+        free(workers);
+        free(search.tasks);
+        free(search.distance);
+        return 1;
+    }
+    for (i = 0; i < search.threadCount; i++) {
+        search.deques[i].tasks = (int *) malloc(sizeof(int) * (search.taskCount / search.threadCount + 1));
+        if (search.deques[i].tasks == NULL) {
+            for (j = 0; j < i; j++) {
+                free(search.deques[j].tasks);
+                pthread_mutex_destroy(&search.deques[j].lock);
+            }
+            free(search.done);
+            free(workers);
+            free(search.tasks);
+            free(search.distance);
+            return 1;
+        }
+        pthread_mutex_init(&search.deques[i].lock, NULL);
+    }
+    pthread_mutex_init(&search.progressLock, NULL);
+    search.bestCost = INT_MAX;
+    search.stopped = 0;
+    search.isCancelled = cancelled;
+    search.snapshotFile = snapshotFile;
+    search.puzzle = puzzle;
+    search.lastSnapshot = time(NULL);
+
+    //no solution is shorter than the cheapest task
+    search.threshold = INT_MAX;
+    for (i = 0; i < search.taskCount; i++) {
+        int f = search.tasks[i].g + search.tasks[i].h + linearConflicts(search.tasks[i].tiles, size);
+        if (f < search.threshold) search.threshold = f;
+    }
+    search.nextThreshold = INT_MAX;
+    if (snapshotFile != NULL && readIdaSnapshot(snapshotFile, size, puzzle, search.taskCount, search.threshold,
+                                                IDA_MAX_PATH, &search.threshold, &search.nextThreshold,
+                                                search.done) == 0) {
+        printf("\nResumed from %s\n", snapshotFile);
+    }
+
+    while (search.threshold < IDA_MAX_PATH) {
+        for (i = 0; i < search.threadCount; i++) {
+            search.deques[i].top = search.deques[i].bottom = 0;
+        }
+        for (i = 0, j = 0; i < search.taskCount; i++) {
+            if (search.done[i]) continue;
+            ida_deque *deque = &search.deques[j++ % search.threadCount];
+            deque->tasks[deque->bottom++] = i;
+        }
+
+        started = 0;
+        for (i = 0; i < search.threadCount; i++) {
+            workers[i].search = &search;
+            workers[i].id = i;
+            workers[i].nodes = 0;
+            if (pthread_create(&threads[started], NULL, idaWorker, &workers[i]) == 0) started++;
+        }
+        //without a free thread the tasks are searched on this one, they are stolen from all deques anyway
+        if (started == 0) idaWorker(&workers[0]);
+        for (i = 0; i < started; i++) {
+            pthread_join(threads[i], NULL);
+        }
+
+        if (search.bestCost != INT_MAX || search.stopped || search.nextThreshold == INT_MAX) break;
+        search.threshold = search.nextThreshold;
+        search.nextThreshold = INT_MAX;
+        memset(search.done, 0, search.taskCount);
+    }
+
+    if (search.bestCost != INT_MAX && (claim == NULL || claim("ida-star"))) {
+        printf("\n\nSolved\n\n");
+        for (i = 0; i < size; i++) {
+            for (j = 0; j < size; j++) {
+                printf("%d ", i == size - 1 && j == size - 1 ? 0 : i * size + j + 1);
+            }
+            printf("\n");
+        }
+        FILE *f = fopen(fileName, "w");
+        if (f != NULL) {
+            fprintf(f, "%d\n", search.bestCost);
+            for (i = 0; i < search.bestCost; i++) {
+                fprintf(f, "%s\n", idaMoveNames[strchr(idaMoves, search.solution[i]) - idaMoves]);
+            }
+            fclose(f);
+        }
+        if (snapshotFile != NULL) remove(snapshotFile);
+    } else if (search.bestCost != INT_MAX || search.stopped || claim != NULL) {
+        //another strategy of the portfolio has the solution or may still find one longer than IDA_MAX_PATH,
+        //unsolvable puzzles are rejected by the portfolio before any strategy starts
+    } else if (search.threshold >= IDA_MAX_PATH) {
+        printf("\n\nSolution is longer than %d moves.", IDA_MAX_PATH - 1);
+    } else {
+        printf("\n\nPuzzle has no solution.");
+    }
+
+    for (i = 0; i < search.threadCount; i++) {
+        free(search.deques[i].tasks);
+        pthread_mutex_destroy(&search.deques[i].lock);
+    }
+    pthread_mutex_destroy(&search.progressLock);
+    free(workers);
+    free(search.done);
+    free(search.tasks);
+    free(search.distance);
+    return 0;
+}
@@ -0,0 +1,51 @@
+#ifndef HW3_IDASTAR_H
+#define HW3_IDASTAR_H
+
+#include <stdbool.h>
+
+//Largest number of squares of a puzzle solved by the parallel IDA*
+#define IDA_MAX_CELLS 64
+//Largest side of a puzzle solved by the parallel IDA*
+#define IDA_MAX_SIDE 8
+//Longest solution path of the parallel IDA*
+#define IDA_MAX_PATH 256
+//The root is split breadth-first until there are at least this many subtree tasks
+#define IDA_SPLIT_TASKS 4096
+//Deepest breadth-first split of the root
+#define IDA_MAX_SPLIT 32
+//Largest number of worker threads
+#define IDA_MAX_THREADS 64
+//A worker asks if the search is cancelled every this many nodes, has to be a power of 2
+#define IDA_CANCEL_NODES 65536
+
+/**Checks if an array-puzzle can reach the solution, from the parity of its permutation and of the square
+ * of 0. Puzzles larger than IDA_MAX_CELLS are not checked.
+ *
+ * @param puzzle
+ * @param size size of the puzzle
+ * @return false if the puzzle has no solution, true otherwise
+ */
+bool puzzleSolvable(int **puzzle, int size);
+
+/**Solves a puzzle with parallel iterative deepening A* (based on Manhattan distance from goal plus the
+ * row and column conflicts of the puzzle).
+ * The root is split breadth-first into subtree tasks, which are shared between the worker threads
+ * on work-stealing deques. Every iteration searches all the tasks up to the threshold, the
+ * threshold and the best solution cost are shared through atomics and the workers stop as soon
+ * as a solution is found, since the first solution of an iteration is optimal.
+ * The path from the root to the solution is written on a text file.
+ * Inside the portfolio the search stops once another strategy has solved the puzzle, and the text file
+ * is only written if the solution is claimed first.
+ *
+ * @param puzzle original puzzle
+ * @param size size of the puzzle
+ * @param fileName name of the output text file
+ * @param snapshotFile name of the snapshot file or NULL
+ * @param claim claims the solution for a strategy of the portfolio, NULL outside of the portfolio
+ * @param cancelled checks if another strategy of the portfolio has solved the puzzle, NULL outside of it
+ * @return 0 on success, 1 otherwise
+ */
+int solveIdaStar(int **puzzle, int size, const char *fileName, const char *snapshotFile,
+                 bool (*claim)(const char *strategy), bool (*cancelled)(void));
+
+#endif //HW3_IDASTAR_H
@@ -2,34 +2,105 @@
 * @brief Automatic N puzzle solver
 *
 * Solves a given N sized puzzle using 1 of the 3 implemented algorithms: Breadth-first search
-* Best-first or A-star. Prints the solution path on a text file.
+* Best-first or A-star. The portfolio mode races Best-first, weighted A-star, A-star, optimal A-star (on
+* moves from root) and the parallel iterative deepening A-star in parallel threads and keeps the first
+* solution of the requested quality (any solution for portfolio, a shortest solution for
+* portfolio-optimal). Prints the solution path on a text file. An optional snapshot file lets a long
+* search be stopped and resumed later. The ida-star mode runs a parallel iterative deepening A-star on
+* all the cores.
 *
 * @author Socrates Yiannakou
 * @bug Writing on a file is inconsistent. Sometimes the output file is not created and the program
  * does not terminate normally. To avoid this, I have the output txt file created before compiling and
- * running this program. Also a character (A) appears near the beginning of the output file.
+ * running this program.
 */
 
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <stdbool.h>
+#include <time.h>
+#include <pthread.h>
 #include "treeNode.h"
 #include "frontierNode.h"
+#include "checkpoint.h"
+#include "idaStar.h"
+#include "symmetry.h"
+#include "stateTable.h"
 
 /**
  * While the queue is not empty, the head of the queue is removed and is available for processing.
  * Then a new tree node is created, for each possible movement of 0 in the puzzle. According to
  * which algorithm the user has selected, a different enqueue method is used. If the node which
  * got dequeued has the final puzzle, the path from the root that node is written on a text file.
+ * With a snapshot file the search resumes from the stored queue and stores its queue periodically.
+ * A puzzle and its reflection across the main diagonal share one canonical key, and a child is only
+ * added if no node with its key was reached in as many moves or fewer, anywhere in the tree.
  *
  * @param root root of the tree
  * @param solution solution of the puzzle
  * @param head head of queue
  * @param tail tail of queue
+ * @param strategy name of the algorithm that orders the queue
  * @return
  */
-int solvePuzzle(tree_node *root, int **solution, frontier_node *head, frontier_node *tail);
+int solvePuzzle(tree_node *root, int **solution, frontier_node *head, frontier_node *tail, const char *strategy);
+
+/**Checks if a child has to be added to the tree and records its key. Without a table the child is
+ * only checked against its ancestors.
+ *
+ * @param table keys reached by the search or NULL
+ * @param parent parent of the child
+ * @param puzzle puzzle of the child
+ * @return true or false
+ */
+bool isNewState(state_table *table, tree_node *parent, int **puzzle);
+
+/**Records the key of every node of a tree, for a search that resumes from a snapshot
+ *
+ * @param table keys reached by the search
+ * @param node
+ */
+void recordTree(state_table *table, tree_node *node);
+
+/**Runs every strategy of the portfolio that meets the requested quality in its own thread, each one on
+ * its own search tree. The first strategy that reaches the solution writes the text file and the rest
+ * are cancelled. An unsolvable puzzle is reported before any strategy starts, since the tree searches
+ * would never end on it.
+ *
+ * @param solution solution of the puzzle
+ * @param optimal true if only a shortest solution is accepted, false for any solution
+ * @return
+ */
+int solvePortfolio(int **solution, bool optimal);
+
+/**Thread routine of a portfolio strategy
+ *
+ * @param arg portfolio entry of the strategy
+ * @return NULL
+ */
+void *portfolioWorker(void *arg);
+
+/**Checks if another strategy of the portfolio has already solved the puzzle
+ *
+ * @return true or false
+ */
+bool portfolioCancelled(void);
+
+/**Checks if a strategy of the portfolio meets the requested quality
+ *
+ * @param strategy name of the algorithm
+ * @return true or false
+ */
+bool meetsQuality(const char *strategy);
+
+/**Claims the solution for a strategy. Only the first strategy of the portfolio that meets the
+ * requested quality succeeds, outside of the portfolio mode the claim always succeeds.
+ *
+ * @param strategy name of the algorithm
+ * @return true or false
+ */
+bool claimSolution(const char *strategy);
 
 /**Checks if 2 arrays-puzzles are equal
  *
@@ -65,8 +136,39 @@ int calculateDistance(int **source, int **destination);
 
 int size = 3;
 char fileName[50];//4rth argument, name of the output txt file
-char algorithm[50]; //2nd argument, 1 of the 3 running choices
+char algorithm[50]; //2nd argument, 1 of the running choices
 int **rootPuzzle; //original puzzle
+const char *snapshotFile = NULL; //optional 5th argument, snapshot of the search
+
+#define PORTFOLIO_SIZE 5
+
+//Strategy of the portfolio and whether its first solution is always a shortest one
+typedef struct portfolio_strategy
+{
+    const char *strategy;
+    bool optimal;
+} portfolio_strategy;
+
+//Strategy raced in the portfolio mode with its own search tree
+typedef struct portfolio_entry
+{
+    const char *strategy;
+    tree_node *root;
+    int **solution;
+} portfolio_entry;
+
+//a-star orders by Manhattan distance from the root, not by moves from the root, so it is not optimal
+const portfolio_strategy portfolioStrategies[PORTFOLIO_SIZE] = {
+        {"best",          false},
+        {"weighted-star", false},
+        {"a-star",        false},
+        {"optimal-star",  true},
+        {"ida-star",      true}
+};
+bool portfolioMode = false;
+bool portfolioOptimal = false; //requested quality, true if only a shortest solution is accepted
+const char *portfolioWinner = NULL; //strategy that solved the puzzle first
+pthread_mutex_t portfolioLock = PTHREAD_MUTEX_INITIALIZER;
 
 int calculateDistance(int **source, int **destination) {
     int sum = 0;
@@ -177,6 +279,22 @@ bool childToRoot(tree_node *node, int **puzzle) {
     return true;
 }
 
+bool isNewState(state_table *table, tree_node *parent, int **puzzle) {
+    unsigned char key[SYMMETRY_MAX_CELLS];
+    if (table == NULL || !puzzleKey(puzzle, size, key)) return childToRoot(parent, puzzle);
+    return visitState(table, key, parent->movesFromRoot + 1);
+}
+
+void recordTree(state_table *table, tree_node *node) {
+    unsigned char key[SYMMETRY_MAX_CELLS];
+    if (node == NULL) return;
+    if (puzzleKey(node->puzzle, size, key)) visitState(table, key, node->movesFromRoot);
+    recordTree(table, node->right);
+    recordTree(table, node->down);
+    recordTree(table, node->left);
+    recordTree(table, node->up);
+}
+
 tree_node *insertTreeNode(int **array, tree_node *parent, int **solution) {
     int i;
     tree_node *node = (tree_node *) malloc(sizeof(tree_node));
@@ -196,21 +314,125 @@ tree_node *insertTreeNode(int **array, tree_node *parent, int **solution) {
     node->down = NULL;
     node->parent = parent;
 
-    node->distanceFromGoal = calculateDistance(node->puzzle, solution);
-    node->starDistance = node->distanceFromGoal + calculateDistance(node->puzzle, rootPuzzle);
+    int distanceFromRoot = calculateDistance(node->puzzle, rootPuzzle);
+    node->distanceFromGoal = calculateDistance(node->puzzle, solution) + puzzleConflicts(node->puzzle, size);
+    node->starDistance = node->distanceFromGoal + distanceFromRoot;
+    node->weightedDistance = STAR_WEIGHT * node->distanceFromGoal + distanceFromRoot;
+    node->movesFromRoot = parent == NULL ? 0 : parent->movesFromRoot + 1;
+    node->optimalDistance = node->distanceFromGoal + node->movesFromRoot;
     return node;
 }
 
-int solvePuzzle(tree_node *root, int **solution, frontier_node *head, frontier_node *tail) {
+bool portfolioCancelled(void) {
+    bool cancelled;
+    if (!portfolioMode) return false;
+    pthread_mutex_lock(&portfolioLock);
+    cancelled = portfolioWinner != NULL;
+    pthread_mutex_unlock(&portfolioLock);
+    return cancelled;
+}
+
+bool meetsQuality(const char *strategy) {
+    int i;
+    if (!portfolioOptimal) return true;
+    for (i = 0; i < PORTFOLIO_SIZE; i++) {
+        if (strcmp(portfolioStrategies[i].strategy, strategy) == 0) return portfolioStrategies[i].optimal;
+    }
+    return false;
+}
+
+bool claimSolution(const char *strategy) {
+    bool claimed = false;
+    if (!portfolioMode) return true;
+    if (!meetsQuality(strategy)) return false;
+    pthread_mutex_lock(&portfolioLock);
+    if (portfolioWinner == NULL) {
+        portfolioWinner = strategy;
+        claimed = true;
+    }
+    pthread_mutex_unlock(&portfolioLock);
+    return claimed;
+}
+
+void *portfolioWorker(void *arg) {
+    portfolio_entry *entry = (portfolio_entry *) arg;
+    if (strcmp(entry->strategy, "ida-star") == 0) {
+        solveIdaStar(rootPuzzle, size, fileName, NULL, claimSolution, portfolioCancelled);
+    } else {
+        solvePuzzle(entry->root, entry->solution, NULL, NULL, entry->strategy);
+    }
+    return NULL;
+}
+
+int solvePortfolio(int **solution, bool optimal) {
+    int i;
+    pthread_t threads[PORTFOLIO_SIZE];
+    bool started[PORTFOLIO_SIZE];
+    portfolio_entry entries[PORTFOLIO_SIZE];
+
+    if (!puzzleSolvable(rootPuzzle, size)) {
+        printf("\n\nPuzzle has no solution.");
+        return 0;
+    }
+    portfolioMode = true;
+    portfolioOptimal = optimal;
+    for (i = 0; i < PORTFOLIO_SIZE; i++) {
+        entries[i].strategy = portfolioStrategies[i].strategy;
+        entries[i].solution = solution;
+        entries[i].root = NULL;
+        started[i] = false;
+        //a strategy that can not claim the solution would only take a core from the others
+        if (!meetsQuality(entries[i].strategy)) continue;
+        //ida-star searches on its own boards, without a tree
+        if (strcmp(entries[i].strategy, "ida-star") != 0) {
+            entries[i].root = insertTreeNode(rootPuzzle, NULL, solution);
+            if (entries[i].root == NULL) continue;
+        }
+        started[i] = pthread_create(&threads[i], NULL, portfolioWorker, &entries[i]) == 0;
+        //without a free thread the strategy still gets its turn on this one
+        if (!started[i]) portfolioWorker(&entries[i]);
+    }
+    for (i = 0; i < PORTFOLIO_SIZE; i++) {
+        if (started[i]) pthread_join(threads[i], NULL);
+        deleteTree(entries[i].root);
+    }
+    portfolioMode = false;
+
+    if (portfolioWinner == NULL) {
+        printf("\n\nPuzzle has no solution.");
+        return 0;
+    }
+    printf("\nSolved by %s\n", portfolioWinner);
+    return 0;
+}
+
+int solvePuzzle(tree_node *root, int **solution, frontier_node *head, frontier_node *tail, const char *strategy) {
 
     bool solved = false;
     int iZero, jZero, i, j;
-    enqueue(&head, &tail, root);
+    time_t lastSnapshot = time(NULL);
+    state_table states;
+    //without a table, or for a puzzle too large for the keys, only the ancestors are checked
+    state_table *table = NULL;
+    if (size * size <= SYMMETRY_MAX_CELLS && initStateTable(&states, size * size) == 0) table = &states;
+    if (snapshotFile != NULL && readSnapshot(snapshotFile, strategy, size, root, solution, &head, &tail) == 0) {
+        printf("\nResumed from %s\n", snapshotFile);
+    } else {
+        enqueue(&head, &tail, root);
+    }
+    if (table != NULL) recordTree(table, root);
 
-    while (!isEmpty(head)) {
+    while (!isEmpty(head) && !portfolioCancelled()) {
+        if (snapshotFile != NULL && difftime(time(NULL), lastSnapshot) >= CHECKPOINT_SECONDS) {
+            if (startSnapshot(snapshotFile, strategy, size, rootPuzzle, root, head) != 0) {
+                printf("\nCould not write snapshot %s\n", snapshotFile);
+            }
+            lastSnapshot = time(NULL);
+        }
         tree_node *temp = dequeue(&head, &tail);
 
         if (areEqual(temp->puzzle, solution)) {
+            if (!claimSolution(strategy)) break;
             solved = true;
             printf("\n\nSolved\n\n");
             for (i = 0; i < size; i++) {
@@ -225,11 +447,19 @@ int solvePuzzle(tree_node *root, int **solution, frontier_node *head, frontier_n
             int count = findPath(temp);
             fprintf(f, "%d\n", count);
             tree_node *temp2 = NULL;
-            char *string = (char *) malloc(sizeof(char) * 1000);
-            findPathStr(temp, temp2, &string);
-            fprintf(f, "%s", string);
-            free(string);
+            //"right\n" is the longest move
+            char *string = (char *) malloc(sizeof(char) * (6 * count + 1));
+            if (string != NULL) {
+                string[0] = '\0';
+                findPathStr(temp, temp2, &string);
+                fprintf(f, "%s", string);
+                free(string);
+            }
             fclose(f);
+            if (snapshotFile != NULL) {
+                stopSnapshot(snapshotFile);
+                remove(snapshotFile);
+            }
             break;
 
         } else {
@@ -246,22 +476,16 @@ int solvePuzzle(tree_node *root, int **solution, frontier_node *head, frontier_n
                 temparray[iZero][jZero] = temparray[iZero][jZero + 1];
                 temparray[iZero][jZero + 1] = tempValue;
 
-                if (childToRoot(temp, temparray)) {
+                if (isNewState(table, temp, temparray)) {
 
                     tree_node *node = insertTreeNode(temparray, temp, solution);
                     temp->right = node;
 
-                    if (strcmp(algorithm, "best") == 0) {
-                        enqueueBest(&head, &tail, node);
-                    } else if (strcmp(algorithm, "a-star") == 0) {
-                        enqueueStar(&head, &tail, node);
-                    } else {
-                        enqueue(&head, &tail, node);
-                    }
-                    for (i = 0; i < size; i++)
-                        free(temparray[i]);
-                    free(temparray);
+                    enqueueStrategy(&head, &tail, node, strategy);
                 }
+                for (i = 0; i < size; i++)
+                    free(temparray[i]);
+                free(temparray);
             }
             if ((iZero + 1) < size) {
 
@@ -274,22 +498,16 @@ int solvePuzzle(tree_node *root, int **solution, frontier_node *head, frontier_n
                 temparray[iZero][jZero] = temparray[iZero + 1][jZero];
                 temparray[iZero + 1][jZero] = tempValue;
 
-                if (childToRoot(temp, temparray)) {
+                if (isNewState(table, temp, temparray)) {
 
                     tree_node *node = insertTreeNode(temparray, temp, solution);
                     temp->down = node;
 
-                    if (strcmp(algorithm, "best") == 0) {
-                        enqueueBest(&head, &tail, node);
-                    } else if (strcmp(algorithm, "a-star") == 0) {
-                        enqueueStar(&head, &tail, node);
-                    } else {
-                        enqueue(&head, &tail, node);
-                    }
-                    for (i = 0; i < size; i++)
-                        free(temparray[i]);
-                    free(temparray);
+                    enqueueStrategy(&head, &tail, node, strategy);
                 }
+                for (i = 0; i < size; i++)
+                    free(temparray[i]);
+                free(temparray);
             }
             if ((jZero - 1) >= 0) {
 
@@ -302,21 +520,15 @@ int solvePuzzle(tree_node *root, int **solution, frontier_node *head, frontier_n
                 temparray[iZero][jZero] = temparray[iZero][jZero - 1];
                 temparray[iZero][jZero - 1] = tempValue;
 
-                if (childToRoot(temp, temparray)) {
+                if (isNewState(table, temp, temparray)) {
                     tree_node *node = insertTreeNode(temparray, temp, solution);
                     temp->left = node;
 
-                    if (strcmp(algorithm, "best") == 0) {
-                        enqueueBest(&head, &tail, node);
-                    } else if (strcmp(algorithm, "a-star") == 0) {
-                        enqueueStar(&head, &tail, node);
-                    } else {
-                        enqueue(&head, &tail, node);
-                    }
-                    for (i = 0; i < size; i++)
-                        free(temparray[i]);
-                    free(temparray);
+                    enqueueStrategy(&head, &tail, node, strategy);
                 }
+                for (i = 0; i < size; i++)
+                    free(temparray[i]);
+                free(temparray);
             }
             if ((iZero - 1) >= 0) {
 
@@ -329,25 +541,24 @@ int solvePuzzle(tree_node *root, int **solution, frontier_node *head, frontier_n
                 temparray[iZero][jZero] = temparray[iZero - 1][jZero];
                 temparray[iZero - 1][jZero] = tempValue;
 
-                if (childToRoot(temp, temparray)) {
+                if (isNewState(table, temp, temparray)) {
                     tree_node *node = insertTreeNode(temparray, temp, solution);
                     temp->up = node;
 
-                    if (strcmp(algorithm, "best") == 0) {
-                        enqueueBest(&head, &tail, node);
-                    } else if (strcmp(algorithm, "a-star") == 0) {
-                        enqueueStar(&head, &tail, node);
-                    } else {
-                        enqueue(&head, &tail, node);
-                    }
-                    for (i = 0; i < size; i++)
-                        free(temparray[i]);
-                    free(temparray);
+                    enqueueStrategy(&head, &tail, node, strategy);
                 }
+                for (i = 0; i < size; i++)
+                    free(temparray[i]);
+                free(temparray);
             }
         }
     }
-    if (solved) {
+    while (!isEmpty(head)) {
+        dequeue(&head, &tail);
+    }
+    if (table != NULL) freeStateTable(table);
+    if (snapshotFile != NULL) stopSnapshot(snapshotFile);
+    if (solved || portfolioMode) {
         return 0;
 
     } else {
@@ -357,14 +568,18 @@ int solvePuzzle(tree_node *root, int **solution, frontier_node *head, frontier_n
 }
 
 int main(int argc, char *argv[]) {
-    if (argc != 4) {
-        printf("\nWrong Input!\nFormat has to be: executable file_algorithm type_input txt_output txt\n ");
+    if (argc != 4 && argc != 5) {
+        printf("\nWrong Input!\nFormat has to be: executable file_algorithm type_input txt_output txt"
+               " [snapshot file]\n ");
         return 1;
     }
 
     char s1[] = "breadth";
     char s2[] = "a-star";
     char s3[] = "best";
+    char s4[] = "portfolio";
+    char s5[] = "ida-star";
+    char s6[] = "portfolio-optimal";
     char line0[100];
     char *point = NULL;
     char *point2 = NULL;
@@ -377,7 +592,8 @@ int main(int argc, char *argv[]) {
     int solutionCount = 1;
 
     //Checks for input errors
-    if (strcmp(s1, argv[1]) != 0 && strcmp(s2, argv[1]) != 0 && strcmp(s3, argv[1]) != 0) {
+    if (strcmp(s1, argv[1]) != 0 && strcmp(s2, argv[1]) != 0 && strcmp(s3, argv[1]) != 0 &&
+        strcmp(s4, argv[1]) != 0 && strcmp(s5, argv[1]) != 0 && strcmp(s6, argv[1]) != 0) {
         printf("\nWrong Input!\nAlgorithm type does not exist.\n ");
         return 1;
     }
@@ -399,6 +615,14 @@ int main(int argc, char *argv[]) {
         return 1;
     }
 
+    if (argc == 5) {
+        if (strcmp(s4, argv[1]) == 0 || strcmp(s6, argv[1]) == 0) {
+            printf("\nWrong Input!\nSnapshots are not supported in portfolio mode.\n ");
+            return 1;
+        }
+        snapshotFile = argv[4];
+    }
+
     FILE *fp = NULL;
     fp = fopen(argv[2], "r");
     if (fp == NULL) {
@@ -470,32 +694,28 @@ int main(int argc, char *argv[]) {
     search_tree->up = NULL;
     search_tree->right = NULL;
     search_tree->left = NULL;
+    search_tree->movesFromRoot = 0;
     memmove(&search_tree->puzzle, &array, sizeof(search_tree->puzzle));
 
-    frontier_node *frontier_head = (frontier_node *) malloc(sizeof(frontier_node));
-    if (frontier_head == NULL)return 1;
-    frontier_node *frontier_tail = (frontier_node *) malloc(sizeof(frontier_node));
-    if (frontier_tail == NULL)return 1;
-
-    frontier_head = frontier_tail;
-    frontier_head->next = NULL;
-    frontier_head->previous = NULL;
-    frontier_head->leaf = search_tree;
+    frontier_node *frontier_head = NULL;
+    frontier_node *frontier_tail = NULL;
     strcpy(algorithm, argv[1]);
-    search_tree->distanceFromGoal = calculateDistance(search_tree->puzzle, solution);
+    search_tree->distanceFromGoal = calculateDistance(search_tree->puzzle, solution) + puzzleConflicts(array, size);
     rootPuzzle = search_tree->puzzle;
 
-    solvePuzzle(search_tree, solution, frontier_head, frontier_tail);
+    if (strcmp(algorithm, s4) == 0 || strcmp(algorithm, s6) == 0) {
+        solvePortfolio(solution, strcmp(algorithm, s6) == 0);
+    } else if (strcmp(algorithm, s5) == 0) {
+        solveIdaStar(rootPuzzle, size, fileName, snapshotFile, NULL, NULL);
+    } else {
+        solvePuzzle(search_tree, solution, frontier_head, frontier_tail, algorithm);
+    }
 
-    //frees memory
+    //frees memory, the input puzzle is freed together with the tree
     for (i = 0; i < size; i++) {
-        free(array[i]);
         free(solution[i]);
     }
-    free(array);
     free(solution);
     deleteTree(search_tree);
-    free(frontier_head);
-    free(frontier_tail);
     return 0;
 }
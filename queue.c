@@ -22,6 +22,8 @@ int enqueueStar(frontier_node **head, frontier_node **tail, tree_node *leaf) {
     frontier_node *node = (frontier_node *) malloc(sizeof(frontier_node));
     if (node == NULL)return 1;
     node->leaf = leaf;
+    node->next = NULL;
+    node->previous = NULL;
 
     if (*head == NULL && *tail == NULL) {
         *head = *tail = node;
@@ -30,6 +32,7 @@ int enqueueStar(frontier_node **head, frontier_node **tail, tree_node *leaf) {
 
     if ((node->leaf->starDistance) < (*head)->leaf->starDistance) {
         node->next = *head;
+        (*head)->previous = node;
         *head = node;
         return 0;
     }
@@ -58,12 +61,15 @@ int enqueueBest(frontier_node **head, frontier_node **tail, tree_node *leaf) {
     frontier_node *node = (frontier_node *) malloc(sizeof(frontier_node));
     if (node == NULL)return 1;
     node->leaf = leaf;
+    node->next = NULL;
+    node->previous = NULL;
     if (*head == NULL && *tail == NULL) {
         *head = *tail = node;
         return 0;
     }
     if ((node->leaf->distanceFromGoal) < (*head)->leaf->distanceFromGoal) {
         node->next = *head;
+        (*head)->previous = node;
         *head = node;
         return 0;
     }
@@ -85,6 +91,76 @@ int enqueueBest(frontier_node **head, frontier_node **tail, tree_node *leaf) {
     return 0;
 }
 
+int enqueueWeighted(frontier_node **head, frontier_node **tail, tree_node *leaf) {
+    if (leaf == NULL)return 1;
+    frontier_node *node = (frontier_node *) malloc(sizeof(frontier_node));
+    if (node == NULL)return 1;
+    node->leaf = leaf;
+    node->next = NULL;
+    node->previous = NULL;
+    if (*head == NULL && *tail == NULL) {
+        *head = *tail = node;
+        return 0;
+    }
+    if ((node->leaf->weightedDistance) < (*head)->leaf->weightedDistance) {
+        node->next = *head;
+        (*head)->previous = node;
+        *head = node;
+        return 0;
+    }
+    frontier_node *current = *head;
+    while (current->next != NULL && ((current->next->leaf->weightedDistance) <= (node->leaf->weightedDistance))) {
+        current = current->next;
+    }
+    if (current == *tail) {
+        node->next = NULL;
+        node->previous = current;
+        current->next = node;
+        *tail = node;
+        return 0;
+    }
+    node->next = current->next;
+    current->next->previous = node;
+    current->next = node;
+    node->previous = current;
+    return 0;
+}
+
+int enqueueOptimal(frontier_node **head, frontier_node **tail, tree_node *leaf) {
+    if (leaf == NULL)return 1;
+    frontier_node *node = (frontier_node *) malloc(sizeof(frontier_node));
+    if (node == NULL)return 1;
+    node->leaf = leaf;
+    node->next = NULL;
+    node->previous = NULL;
+    if (*head == NULL && *tail == NULL) {
+        *head = *tail = node;
+        return 0;
+    }
+    if ((node->leaf->optimalDistance) < (*head)->leaf->optimalDistance) {
+        node->next = *head;
+        (*head)->previous = node;
+        *head = node;
+        return 0;
+    }
+    frontier_node *current = *head;
+    while (current->next != NULL && ((current->next->leaf->optimalDistance) <= (node->leaf->optimalDistance))) {
+        current = current->next;
+    }
+    if (current == *tail) {
+        node->next = NULL;
+        node->previous = current;
+        current->next = node;
+        *tail = node;
+        return 0;
+    }
+    node->next = current->next;
+    current->next->previous = node;
+    current->next = node;
+    node->previous = current;
+    return 0;
+}
+
 int enqueue(frontier_node **head, frontier_node **tail, tree_node *leaf) {
     if (leaf == NULL)return 1;
     frontier_node *node = (frontier_node *) malloc(sizeof(frontier_node));
@@ -101,14 +177,29 @@ int enqueue(frontier_node **head, frontier_node **tail, tree_node *leaf) {
     return 0;
 }
 
+int enqueueStrategy(frontier_node **head, frontier_node **tail, tree_node *leaf, const char *strategy) {
+    if (strcmp(strategy, "best") == 0) {
+        return enqueueBest(head, tail, leaf);
+    } else if (strcmp(strategy, "a-star") == 0) {
+        return enqueueStar(head, tail, leaf);
+    } else if (strcmp(strategy, "weighted-star") == 0) {
+        return enqueueWeighted(head, tail, leaf);
+    } else if (strcmp(strategy, "optimal-star") == 0) {
+        return enqueueOptimal(head, tail, leaf);
+    }
+    return enqueue(head, tail, leaf);
+}
+
 tree_node *dequeue(frontier_node **head, frontier_node **tail) {
     if (*head == NULL || *tail == NULL) return NULL;
     frontier_node *temp = *head;
+    tree_node *leaf = temp->leaf;
     if (*head == *tail) {
         *head = *tail = NULL;
+    } else {
+        ((*head)->next)->previous = NULL;
+        *head = (*head)->next;
     }
-    ((*head)->next)->previous = NULL;
-    *head = (*head)->next;
     free(temp);
-    return temp->leaf;
+    return leaf;
 }
\ No newline at end of file
@@ -0,0 +1,110 @@
+/**
+ * Implements the hash table of the boards reached by a tree search, with open addressing
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include "stateTable.h"
+
+/**Calculates the FNV-1a hash of a board
+ *
+ * @param key board
+ * @param cells number of squares of the puzzle
+ * @return the hash
+ */
+unsigned long hashState(const unsigned char *key, int cells);
+
+/**Finds the slot of a board, or the empty slot where it goes
+ *
+ * @param table
+ * @param key board
+ * @return index of the slot
+ */
+long findSlot(const state_table *table, const unsigned char *key);
+
+/**Doubles the slots of a table and moves every board to its new slot
+ *
+ * @param table
+ * @return 0 on success, 1 otherwise
+ */
+int growStateTable(state_table *table);
+
+unsigned long hashState(const unsigned char *key, int cells) {
+    unsigned long hash = 2166136261UL;
+    int i;
+    for (i = 0; i < cells; i++) {
+        hash = (hash ^ key[i]) * 16777619UL;
+    }
+    return hash;
+}
+
+long findSlot(const state_table *table, const unsigned char *key) {
+    long slot = (long) (hashState(key, table->cells) & (unsigned long) (table->capacity - 1));
+    while (table->moves[slot] >= 0 && memcmp(&table->keys[slot * table->cells], key, table->cells) != 0) {
+        slot = (slot + 1) & (table->capacity - 1);
+    }
+    return slot;
+}
+
+int initStateTable(state_table *table, int cells) {
+    table->cells = cells;
+    table->capacity = STATE_TABLE_START;
+    table->count = 0;
+    table->keys = (unsigned char *) malloc(table->capacity * cells);
+    table->moves = (int *) malloc(sizeof(int) * table->capacity);
+    if (table->keys == NULL || table->moves == NULL) {
+        freeStateTable(table);
+        return 1;
+    }
+    memset(table->moves, -1, sizeof(int) * table->capacity);
+    return 0;
+}
+
+int growStateTable(state_table *table) {
+    state_table bigger = *table;
+    long i, slot;
+    bigger.capacity = table->capacity * 2;
+    bigger.keys = (unsigned char *) malloc(bigger.capacity * table->cells);
+    bigger.moves = (int *) malloc(sizeof(int) * bigger.capacity);
+    if (bigger.keys == NULL || bigger.moves == NULL) {
+        free(bigger.keys);
+        free(bigger.moves);
+        return 1;
+    }
+    memset(bigger.moves, -1, sizeof(int) * bigger.capacity);
+    for (i = 0; i < table->capacity; i++) {
+        if (table->moves[i] < 0) continue;
+        slot = findSlot(&bigger, &table->keys[i * table->cells]);
+        memcpy(&bigger.keys[slot * table->cells], &table->keys[i * table->cells], table->cells);
+        bigger.moves[slot] = table->moves[i];
+    }
+    free(table->keys);
+    free(table->moves);
+    *table = bigger;
+    return 0;
+}
+
+bool visitState(state_table *table, const unsigned char *key, int moves) {
+    long slot;
+    //without memory to grow, the boards are still searched but no longer recorded
+    if (table->count * 2 >= table->capacity && growStateTable(table) != 0 &&
+        table->count * 4 >= table->capacity * 3) {
+        return true;
+    }
+    slot = findSlot(table, key);
+    if (table->moves[slot] < 0) {
+        memcpy(&table->keys[slot * table->cells], key, table->cells);
+        table->count++;
+    } else if (table->moves[slot] <= moves) {
+        return false;
+    }
+    table->moves[slot] = moves;
+    return true;
+}
+
+void freeStateTable(state_table *table) {
+    free(table->keys);
+    free(table->moves);
+    table->keys = NULL;
+    table->moves = NULL;
+}
@@ -0,0 +1,43 @@
+#ifndef HW3_STATETABLE_H
+#define HW3_STATETABLE_H
+
+#include <stdbool.h>
+
+//Number of slots of a new state table, has to be a power of 2
+#define STATE_TABLE_START 1024
+
+//Hash table of the canonical boards reached by a search, with the fewest moves from the root of each one
+typedef struct state_table
+{
+    unsigned char *keys; //canonical board of every slot, cells bytes each
+    int *moves; //fewest moves from the root of every slot, -1 for an empty slot
+    long capacity;
+    long count;
+    int cells;
+} state_table;
+
+/**Creates an empty state table
+ *
+ * @param table
+ * @param cells number of squares of the puzzle
+ * @return 0 on success, 1 otherwise
+ */
+int initStateTable(state_table *table, int cells);
+
+/**Records that a search reached a board. A board that was already reached with as many moves or fewer
+ * is not needed again, its subtree is searched from the earlier node.
+ *
+ * @param table
+ * @param key canonical board
+ * @param moves moves from the root
+ * @return true if the board is new or reached with fewer moves, false otherwise
+ */
+bool visitState(state_table *table, const unsigned char *key, int moves);
+
+/**Frees the memory of a state table
+ *
+ * @param table
+ */
+void freeStateTable(state_table *table);
+
+#endif //HW3_STATETABLE_H
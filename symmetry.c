@@ -0,0 +1,93 @@
+/**
+ * Implements the reflection of the puzzle across the main diagonal and the linear conflicts
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include "symmetry.h"
+
+/**Finds the tile whose goal square is the reflection of the goal square of a tile
+ *
+ * @param tile
+ * @param size size of the puzzle
+ * @return the reflected tile
+ */
+int reflectTile(int tile, int size);
+
+int reflectTile(int tile, int size) {
+    if (tile == 0) return 0;
+    return ((tile - 1) % size) * size + (tile - 1) / size + 1;
+}
+
+void reflectBoard(const unsigned char *tiles, unsigned char *reflected, int size) {
+    int i, j;
+    for (i = 0; i < size; i++) {
+        for (j = 0; j < size; j++) {
+            reflected[i * size + j] = (unsigned char) reflectTile(tiles[j * size + i], size);
+        }
+    }
+}
+
+void canonicalBoard(const unsigned char *tiles, unsigned char *canonical, int size) {
+    reflectBoard(tiles, canonical, size);
+    if (memcmp(tiles, canonical, size * size) < 0) memcpy(canonical, tiles, size * size);
+}
+
+int lineConflicts(const unsigned char *tiles, int size, int line, bool column) {
+    int count = 0, longest = 0, k, i;
+    int goalPlaces[SYMMETRY_MAX_CELLS], run[SYMMETRY_MAX_CELLS];
+    for (k = 0; k < size; k++) {
+        if (column) {
+            int goal = tiles[k * size + line] - 1;
+            if (goal >= 0 && goal % size == line) goalPlaces[count++] = goal / size;
+        } else {
+            int goal = tiles[line * size + k] - 1 - line * size;
+            if (goal >= 0 && goal < size) goalPlaces[count++] = goal;
+        }
+    }
+    //longest run of tiles in goal order, they can stay in the line
+    for (k = 0; k < count; k++) {
+        run[k] = 1;
+        for (i = 0; i < k; i++) {
+            if (goalPlaces[i] < goalPlaces[k] && run[i] + 1 > run[k]) run[k] = run[i] + 1;
+        }
+        if (run[k] > longest) longest = run[k];
+    }
+    return 2 * (count - longest);
+}
+
+int linearConflicts(const unsigned char *tiles, int size) {
+    int conflicts = 0, line;
+    for (line = 0; line < size; line++) {
+        conflicts += lineConflicts(tiles, size, line, false) + lineConflicts(tiles, size, line, true);
+    }
+    return conflicts;
+}
+
+int puzzleConflicts(int **puzzle, int size) {
+    unsigned char tiles[SYMMETRY_MAX_CELLS];
+    int i, j;
+    if (size * size > SYMMETRY_MAX_CELLS) return 0;
+    for (i = 0; i < size; i++) {
+        for (j = 0; j < size; j++) {
+            if (puzzle[i][j] < 0 || puzzle[i][j] >= size * size) return 0;
+            tiles[i * size + j] = (unsigned char) puzzle[i][j];
+        }
+    }
+    return linearConflicts(tiles, size);
+}
+
+bool puzzleKey(int **puzzle, int size, unsigned char *key) {
+    unsigned char tiles[SYMMETRY_MAX_CELLS];
+    int i, j;
+    if (size * size > SYMMETRY_MAX_CELLS) return false;
+    for (i = 0; i < size; i++) {
+        for (j = 0; j < size; j++) {
+            if (puzzle[i][j] < 0 || puzzle[i][j] >= size * size) return false;
+            tiles[i * size + j] = (unsigned char) puzzle[i][j];
+        }
+    }
+    canonicalBoard(tiles, key, size);
+    return true;
+}
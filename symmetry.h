@@ -0,0 +1,67 @@
+#ifndef HW3_SYMMETRY_H
+#define HW3_SYMMETRY_H
+
+#include <stdbool.h>
+
+//Largest number of squares of a puzzle handled by the symmetry functions
+#define SYMMETRY_MAX_CELLS 64
+
+/**Reflects a board across the main diagonal. Every tile is renamed to the tile whose goal square is
+ * the reflection of its own goal square, so the solution is reflected to itself and a reflected board
+ * needs as many moves as the original (right and down, left and up are swapped).
+ *
+ * @param tiles board, row by row
+ * @param reflected stores the reflected board
+ * @param size size of the puzzle
+ */
+void reflectBoard(const unsigned char *tiles, unsigned char *reflected, int size);
+
+/**Finds the canonical board of a board and its reflection, the one that is smaller byte by byte.
+ * Reflected boards have the same canonical board.
+ *
+ * @param tiles board, row by row
+ * @param canonical stores the canonical board
+ * @param size size of the puzzle
+ */
+void canonicalBoard(const unsigned char *tiles, unsigned char *canonical, int size);
+
+/**Calculates the linear conflicts of a board: the extra moves of the tiles that are in their goal row or
+ * goal column but in the wrong order. In each line, the tiles outside the longest run in goal order have
+ * to leave the line and come back. Leaving a row takes vertical moves and leaving a column horizontal
+ * ones, which the Manhattan distance does not count, so the rows and the columns are added up.
+ *
+ * @param tiles board, row by row
+ * @param size size of the puzzle
+ * @return 2 moves for every such tile of every line
+ */
+int linearConflicts(const unsigned char *tiles, int size);
+
+/**Calculates the row conflicts of one row of a board, or the conflicts of one column. The conflicts of
+ * column i are the conflicts of row i of the reflected board, so they can be kept up to date move by move.
+ *
+ * @param tiles board, row by row
+ * @param size size of the puzzle
+ * @param line row or column
+ * @param column true for a column
+ * @return 2 moves for every tile outside the longest run in goal order
+ */
+int lineConflicts(const unsigned char *tiles, int size, int line, bool column);
+
+/**Calculates the linear conflicts of an array-puzzle
+ *
+ * @param puzzle
+ * @param size size of the puzzle
+ * @return linear conflicts, 0 if the puzzle is too large
+ */
+int puzzleConflicts(int **puzzle, int size);
+
+/**Finds the canonical board of an array-puzzle, the key under which a search records it
+ *
+ * @param puzzle
+ * @param size size of the puzzle
+ * @param key stores the canonical board, size * size bytes
+ * @return true or false if the puzzle is too large
+ */
+bool puzzleKey(int **puzzle, int size, unsigned char *key);
+
+#endif //HW3_SYMMETRY_H
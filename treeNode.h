@@ -4,12 +4,19 @@
 #include <stdio.h>
 #include <stdbool.h>
 
+//Weight of the distance from goal in the weighted A* ordering
+#define STAR_WEIGHT 2
+
 //Tree with 1 to 4 childs data structure
 typedef struct tree_node
 {
     int **puzzle;
     int distanceFromGoal;
     int starDistance;
+    int weightedDistance;
+    int movesFromRoot;
+    int optimalDistance; //moves from root plus distance from goal
+    int snapshotIndex; //preorder index of the node in the last snapshot
     struct tree_node *parent;
     struct tree_node *right;
     struct tree_node *down;